@@ -19,4 +19,57 @@ struct ADCSReaderStatus {
    struct ADCS3DData mag_pz;
 } __attribute__((packed));
 
+// Command number of the timestamped status request.  The request payload
+//  is an optional single byte holding one of the ADCS_TIMED_MODE_* values
+#define ADCS_TIMED_STATUS_CMD 2
+
+// Report each sensor's most recent reading as-is
+#define ADCS_TIMED_MODE_RAW 0
+// Interpolate sensors onto the snapshot's common sample instant where
+//  possible.  Only sensors flagged ADCS_TIMED_FLAG_INTERP describe the sample
+//  instant; those with an unchanged cache, a failed read, or a single reading
+//  hold their newest value.  Consumers must check the flag per sensor
+#define ADCS_TIMED_MODE_ALIGNED 1
+
+// Sensor is present and has produced at least one reading
+#define ADCS_TIMED_FLAG_VALID (1 << 0)
+// Sensor returned new data during this snapshot (age_us is then 0)
+#define ADCS_TIMED_FLAG_FRESH (1 << 1)
+// Value was linearly interpolated between two readings (aligned mode only)
+#define ADCS_TIMED_FLAG_INTERP (1 << 2)
+
+// One sensor's reading along with when it was taken.  All times are in
+//  microseconds and derived from CLOCK_MONOTONIC on the reader.
+//  capture_offset_us: time the sensor was polled minus the sample instant
+//  age_us: time the sensor was polled minus the timed status poll that first
+//     saw the reported value.  This is a lower bound on the data's true age.
+//     Non-zero for sensors whose read failed, in which case the last good
+//     value is used, and for magnetometers whose value has not changed.
+//     Unchanged magnetometer readings count as stale by design, since their
+//     driver cache carries no timestamp.  Saturates at UINT32_MAX
+//  In aligned mode both fields still describe the newest raw reading, not the
+//   interpolated value
+struct ADCSTimedData {
+   struct ADCS3DData data;
+   int32_t capture_offset_us;
+   uint32_t age_us;
+   uint8_t flags;
+} __attribute__((packed));
+
+struct ADCSReaderTimedStatus {
+   // Monotonic time of the common sample instant for this snapshot
+   uint32_t sample_sec;
+   uint32_t sample_usec;
+   uint8_t mode;
+   struct ADCSTimedData accel;
+   struct ADCSTimedData gyro;
+   struct ADCSTimedData mag_mb;
+   struct ADCSTimedData mag_nx;
+   struct ADCSTimedData mag_px;
+   struct ADCSTimedData mag_ny;
+   struct ADCSTimedData mag_py;
+   struct ADCSTimedData mag_nz;
+   struct ADCSTimedData mag_pz;
+} __attribute__((packed));
+
 #endif
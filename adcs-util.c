@@ -30,6 +30,7 @@
 struct MulticallInfo;
 
 static int adcs_status(int, char**, struct MulticallInfo *);
+static int adcs_timed_status(int, char**, struct MulticallInfo *);
 static int adcs_telemetry(int, char**, struct MulticallInfo *);
 static int adcs_datalogger(int, char**, struct MulticallInfo *);
 static int adcs_sensor_metadata(int, char **, struct MulticallInfo *);
@@ -47,6 +48,8 @@ struct MulticallInfo {
 } multicall[] = {
    { &adcs_status, "adcs-status", "-S", 
        "Display the current status of the adcs process -S" }, 
+   { &adcs_timed_status, "adcs-timed-status", "-TS", 
+       "Display the current status with per-sensor timing -TS [-a aligns sensors]" }, 
    { &adcs_telemetry, "adcs-telemetry", "-T", 
        "Display the current KVP telemetry of the adcs process -T" }, 
    { &adcs_datalogger, "adcs-datalogger", "-dl", 
@@ -141,6 +144,87 @@ static int adcs_status(int argc, char **argv, struct MulticallInfo * self)
    return 0;
 }
 
+// prints one sensor of the timed status, a scale of 0 prints raw integers
+static void print_timed_data(const char *name, const char *units,
+   double scale, struct ADCSTimedData *td)
+{
+   if (scale) {
+      printf("%s X=%f [%s]\n", name, ((int32_t)ntohl(td->data.x)) / scale, units);
+      printf("%s Y=%f [%s]\n", name, ((int32_t)ntohl(td->data.y)) / scale, units);
+      printf("%s Z=%f [%s]\n", name, ((int32_t)ntohl(td->data.z)) / scale, units);
+   }
+   else {
+      printf("%s X=%d [%s]\n", name, (int32_t)ntohl(td->data.x), units);
+      printf("%s Y=%d [%s]\n", name, (int32_t)ntohl(td->data.y), units);
+      printf("%s Z=%d [%s]\n", name, (int32_t)ntohl(td->data.z), units);
+   }
+   printf("%s Offset=%d [us]\n", name, (int32_t)ntohl(td->capture_offset_us));
+   printf("%s Age=%u [us]\n", name, ntohl(td->age_us));
+   printf("%s Flags=%s%s%s\n", name,
+         (td->flags & ADCS_TIMED_FLAG_VALID) ? "valid " : "",
+         (td->flags & ADCS_TIMED_FLAG_FRESH) ? "fresh " : "",
+         (td->flags & ADCS_TIMED_FLAG_INTERP) ? "interpolated" : "");
+}
+
+static int adcs_timed_status(int argc, char **argv, struct MulticallInfo * self) 
+{
+   struct {
+      uint8_t cmd;
+      struct ADCSReaderTimedStatus status;
+   } __attribute__((packed)) resp;
+
+   struct {
+      uint8_t cmd;
+      uint8_t mode;
+   } __attribute__((packed)) send;
+
+   send.cmd = ADCS_TIMED_STATUS_CMD;
+   send.mode = ADCS_TIMED_MODE_RAW;
+   const char *ip = "127.0.0.1";
+   int len, opt;
+   
+   while ((opt = getopt(argc, argv, "h:a")) != -1) {
+      switch(opt) {
+         case 'h':
+            ip = optarg;
+            break;
+         case 'a':
+            send.mode = ADCS_TIMED_MODE_ALIGNED;
+            break;
+      }
+   }
+   
+   // send packet and wait for response
+   if ((len = socket_send_packet_and_read_response(ip, "adcs", &send, 
+    sizeof(send), &resp, sizeof(resp), WAIT_MS)) <= 0) {
+      return len;
+   }
+ 
+   if (resp.cmd != CMD_STATUS_RESPONSE) {
+      printf("response code incorrect, Got 0x%02X expected 0x%02X\n", 
+       resp.cmd, CMD_STATUS_RESPONSE);
+      return 5;
+   }
+
+   // print out returned status values   
+   printf("Sample Time=%u.%06u [s]\n", ntohl(resp.status.sample_sec),
+         ntohl(resp.status.sample_usec));
+   printf("Mode=%s\n", resp.status.mode == ADCS_TIMED_MODE_ALIGNED ?
+         "aligned" : "raw");
+
+   print_timed_data("Accel", "G", 1024.0*1024.0*16.0, &resp.status.accel);
+   print_timed_data("Gyro", "d/s", 1024.0*1024.0, &resp.status.gyro);
+   print_timed_data("MB Mag", "nT", 0, &resp.status.mag_mb);
+   print_timed_data("-X Mag", "nT", 0, &resp.status.mag_nx);
+   print_timed_data("+X Mag", "nT", 0, &resp.status.mag_px);
+   print_timed_data("-Y Mag", "nT", 0, &resp.status.mag_ny);
+   print_timed_data("+Y Mag", "nT", 0, &resp.status.mag_py);
+   print_timed_data("-Z Mag", "nT", 0, &resp.status.mag_nz);
+   print_timed_data("+Z Mag", "nT", 0, &resp.status.mag_pz);
+   
+   return 0;
+}
+
 static struct TELMEventInfo events[] = {
    { 0, 0, NULL, NULL }
 };
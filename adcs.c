@@ -38,6 +38,12 @@ static struct ADCSState *gState;
 #define GYRO_TYPE_FLAG (1 << 1)
 #define MAG_TYPE_FLAG (1 << 2)
 
+// Host-order sensor reading along with the monotonic time it was produced
+struct SensorSample {
+   int32_t x, y, z;
+   uint64_t time_us;
+};
+
 // Structure to hold sensor related information
 // This enables generic sensor handling code, minimizing special cases
 struct SensorInfo {
@@ -45,32 +51,48 @@ struct SensorInfo {
    const char *location;
    const char *type;
    int flags;
-   void (*marshal)(struct SensorInfo *sensor, void *dst);
+   int (*read)(struct SensorInfo *sensor, struct SensorSample *dst);
    int offset;
+   int timed_offset;
    struct Sensor *sensor;
    struct DeviceInfo *dev_info;
    int disabled;
+   // Two most recent distinct readings, used for age and interpolation
+   //  The history only advances on timed status requests, so the spacing
+   //  between prev and curr is set by the timed status clients alone
+   struct SensorSample curr, prev;
+   int num_samples;
+   // Result of the last poll by any status command
+   struct SensorSample latest;
+   // Monotonic time of the last poll, whether the read succeeded, and
+   //  whether it recorded a new sample into the history
+   uint64_t capture_us;
+   int read_ok;
+   int new_sample;
 };
 
-// Declarations of functions that read sensor values and pack them
-//  into status response
-static void marshal_accel(struct SensorInfo *si, void *dst);
-static void marshal_gyro(struct SensorInfo *si, void *dst);
-static void marshal_mag(struct SensorInfo *si, void *dst);
+// Declarations of functions that read sensor values in host byte order
+//  Each returns < 0 if no data was available
+static int read_accel(struct SensorInfo *si, struct SensorSample *dst);
+static int read_gyro(struct SensorInfo *si, struct SensorSample *dst);
+static int read_mag(struct SensorInfo *si, struct SensorSample *dst);
 
 #define ACCEL_SENSOR(n,l,field) { n, l, DRVR_CLS_ACCELEROMETER, \
-    ACCEL_TYPE_FLAG, &marshal_accel, \
+    ACCEL_TYPE_FLAG, &read_accel, \
     offsetof(struct ADCSReaderStatus, field), \
+    offsetof(struct ADCSReaderTimedStatus, field), \
     NULL, NULL, 0 }
 
 #define GYRO_SENSOR(n,l,field) { n, l, DRVR_CLS_GYROSCOPE, \
-    GYRO_TYPE_FLAG, &marshal_gyro, \
+    GYRO_TYPE_FLAG, &read_gyro, \
     offsetof(struct ADCSReaderStatus, field), \
+    offsetof(struct ADCSReaderTimedStatus, field), \
     NULL, NULL, 0 }
 
 #define MAG_SENSOR(n,l,field) { n, l, DRVR_CLS_MAGNETOMETER, \
-    MAG_TYPE_FLAG, &marshal_mag, \
+    MAG_TYPE_FLAG, &read_mag, \
     offsetof(struct ADCSReaderStatus, field), \
+    offsetof(struct ADCSReaderTimedStatus, field), \
     NULL, NULL, 0 }
 
 // Sensors managed by this process
@@ -84,67 +106,169 @@ struct SensorInfo sensors[] = {
    MAG_SENSOR("Magnetometer", DEVICE_LOCATION_PLUS_Y, mag_py),
    MAG_SENSOR("Magnetometer", DEVICE_LOCATION_MINUS_X, mag_nx),
    MAG_SENSOR("Magnetometer", DEVICE_LOCATION_PLUS_X, mag_px),
-   { NULL, NULL, NULL, 0, NULL, 0, NULL, NULL, 0 }
+   { NULL, NULL, NULL, 0, NULL, 0, 0, NULL, NULL, 0 }
 };
 
-static void marshal_accel(struct SensorInfo *si, void *dst)
+static uint64_t monotonic_us(void)
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static int read_accel(struct SensorInfo *si, struct SensorSample *dst)
 {
    struct AccelerometerSensor *accel = (struct AccelerometerSensor*)si->sensor;
-   struct ADCS3DData *ad = (struct ADCS3DData*)dst;
    AccelData accelCache;
 
-   if (accel->read) {
-      accel->read(accel, &accelCache);
+   if (!accel->read || accel->read(accel, &accelCache) < 0)
+      return -1;
 
-      ad->x = htonl(accelCache.x_result);
-      ad->y = htonl(accelCache.y_result);
-      ad->z = htonl(accelCache.z_result);
-   }
-   // ad->x = htonl(accel->accelCache.x_result);
-   // ad->y = htonl(accel->accelCache.y_result);
-   // ad->z = htonl(accel->accelCache.z_result);
+   dst->x = accelCache.x_result;
+   dst->y = accelCache.y_result;
+   dst->z = accelCache.z_result;
+   return 0;
 }
 
-static void marshal_gyro(struct SensorInfo *si, void *dst)
+static int read_gyro(struct SensorInfo *si, struct SensorSample *dst)
 {
    struct GyroscopeSensor *gyro = (struct GyroscopeSensor*)si->sensor;
-   struct ADCS3DData *gd = (struct ADCS3DData*)dst;
    GyroData data;
 
-   if (gyro->read) {
-      if (gyro->read(gyro, &data) >= 0) {
-         gd->x = htonl(data.x);
-         gd->y = htonl(data.y);
-         gd->z = htonl(data.z);
-      }
-   }
+   if (!gyro->read || gyro->read(gyro, &data) < 0)
+      return -1;
+
+   dst->x = data.x;
+   dst->y = data.y;
+   dst->z = data.z;
+   return 0;
 }
 
-static void marshal_mag(struct SensorInfo *si, void *dst)
+static int read_mag(struct SensorInfo *si, struct SensorSample *dst)
 {
    struct MagnetometerSensor *mag = (struct MagnetometerSensor*)si->sensor;
-   struct ADCS3DData *md = (struct ADCS3DData*)dst;
 
-   md->x = htonl(mag->magnetometerCache.x_result);
-   md->y = htonl(mag->magnetometerCache.y_result);
-   md->z = htonl(mag->magnetometerCache.z_result);
+   dst->x = mag->magnetometerCache.x_result;
+   dst->y = mag->magnetometerCache.y_result;
+   dst->z = mag->magnetometerCache.z_result;
+   return 0;
 }
 
-// Read all the sensors and place their values into the status packet
-static void marshal_sensors(void *dst)
+// Poll every sensor once, optionally recording the results in its sample
+//  history.  The magnetometer drivers do not timestamp their cache, so a
+//  magnetometer reading only counts as new data if it differs from the
+//  previous one, and is stamped with the poll that first saw it.  Unchanged
+//  readings keep aging by design, even if the driver refreshed them.
+//  Hardware-read sensors always record a new sample
+static void sample_sensors(int record_history)
 {
    struct SensorInfo *curr;
+   struct SensorSample sample;
    struct timeval now;
 
    gettimeofday(&now, NULL);
    for (curr = sensors; curr->name; curr++) {
-      if (curr->offset < 0 || !curr->sensor || !curr->marshal)
+      curr->read_ok = 0;
+      curr->new_sample = 0;
+      if (curr->offset < 0 || !curr->sensor || !curr->read)
          continue;
 
       if (curr->sensor->update_cached_values)
          curr->sensor->update_cached_values(curr->sensor, &now);
 
-      curr->marshal(curr, ((char*)dst) + curr->offset);
+      curr->capture_us = monotonic_us();
+      if (curr->read(curr, &sample) < 0)
+         continue;
+
+      curr->read_ok = 1;
+      curr->latest = sample;
+      if (!record_history)
+         continue;
+
+      if ((curr->flags & MAG_TYPE_FLAG) && curr->num_samples &&
+            sample.x == curr->curr.x && sample.y == curr->curr.y &&
+            sample.z == curr->curr.z)
+         continue;
+
+      curr->new_sample = 1;
+      sample.time_us = curr->capture_us;
+      curr->prev = curr->curr;
+      curr->curr = sample;
+      if (curr->num_samples < 2)
+         curr->num_samples++;
+   }
+}
+
+// Place the latest sensor values into the status packet
+static void marshal_sensors(void *dst)
+{
+   struct SensorInfo *curr;
+   struct ADCS3DData *ad;
+
+   sample_sensors(0);
+   for (curr = sensors; curr->name; curr++) {
+      if (curr->offset < 0 || !curr->read_ok)
+         continue;
+
+      ad = (struct ADCS3DData*)(((char*)dst) + curr->offset);
+      ad->x = htonl(curr->latest.x);
+      ad->y = htonl(curr->latest.y);
+      ad->z = htonl(curr->latest.z);
+   }
+}
+
+static int32_t interpolate(int32_t prev, int32_t curr, double frac)
+{
+   return (int32_t)(prev + (curr - (double)prev) * frac);
+}
+
+// Place the latest sensor values, with their timing, into the timed status
+//  packet.  In aligned mode each value is linearly interpolated between the
+//  sensor's two most recent readings onto the sample instant when the
+//  instant falls between them, and otherwise the newest reading is held
+//  without ADCS_TIMED_FLAG_INTERP
+static void marshal_timed_sensors(struct ADCSReaderTimedStatus *dst, int mode)
+{
+   struct SensorInfo *curr;
+   struct ADCSTimedData *td;
+   struct SensorSample val;
+   uint64_t sample_us, age_us;
+   double frac;
+
+   sample_us = monotonic_us();
+   sample_sensors(1);
+
+   dst->sample_sec = htonl(sample_us / 1000000);
+   dst->sample_usec = htonl(sample_us % 1000000);
+   dst->mode = mode;
+
+   for (curr = sensors; curr->name; curr++) {
+      if (curr->timed_offset < 0 || !curr->num_samples)
+         continue;
+
+      td = (struct ADCSTimedData*)(((char*)dst) + curr->timed_offset);
+      td->flags = ADCS_TIMED_FLAG_VALID;
+      if (curr->new_sample)
+         td->flags |= ADCS_TIMED_FLAG_FRESH;
+
+      val = curr->curr;
+      if (mode == ADCS_TIMED_MODE_ALIGNED && curr->num_samples > 1 &&
+            curr->prev.time_us <= sample_us && sample_us < curr->curr.time_us) {
+         frac = (double)(sample_us - curr->prev.time_us) /
+            (curr->curr.time_us - curr->prev.time_us);
+         val.x = interpolate(curr->prev.x, curr->curr.x, frac);
+         val.y = interpolate(curr->prev.y, curr->curr.y, frac);
+         val.z = interpolate(curr->prev.z, curr->curr.z, frac);
+         td->flags |= ADCS_TIMED_FLAG_INTERP;
+      }
+
+      td->data.x = htonl(val.x);
+      td->data.y = htonl(val.y);
+      td->data.z = htonl(val.z);
+      td->capture_offset_us = htonl((int32_t)(curr->capture_us - sample_us));
+      age_us = curr->capture_us - curr->curr.time_us;
+      td->age_us = htonl(age_us > UINT32_MAX ? UINT32_MAX : (uint32_t)age_us);
    }
 }
 
@@ -161,6 +285,25 @@ void adcs_status(int socket, unsigned char cmd, void * data,
                sizeof(status), src);
 }
 
+void adcs_timed_status(int socket, unsigned char cmd, void * data,
+   size_t dataLen, struct sockaddr_in * src)
+{
+   struct ADCSReaderTimedStatus status;
+   struct ADCSState *adcs = gState;
+   int mode = ADCS_TIMED_MODE_RAW;
+
+   if (dataLen >= 1)
+      mode = *(uint8_t*)data;
+   if (mode != ADCS_TIMED_MODE_RAW && mode != ADCS_TIMED_MODE_ALIGNED)
+      mode = ADCS_TIMED_MODE_RAW;
+
+   memset(&status, 0, sizeof(status));
+   marshal_timed_sensors(&status, mode);
+
+   PROC_cmd_sockaddr(adcs->proc, CMD_STATUS_RESPONSE, &status,
+               sizeof(status), src);
+}
+
 // Initializes the sensors slowly via event callbacks to minimize impact on
 //  event loop stalling the process
 int initialize_cfged_sensors(void * arg)